@@ -0,0 +1,79 @@
+import argparse
+import os
+import re
+import subprocess
+
+parser = argparse.ArgumentParser(
+    prog='scaling',
+    description='Run strong and weak scaling series of a true-2D benchmark case')
+parser.add_argument("exe", help="Path to the spark-benchmark executable")
+parser.add_argument("-c", "--case", type=int, default=5,
+                    help="Benchmark case used as the base problem (5: 257x257, 6: 513x513)")
+parser.add_argument("-t", "--threads", default="1,2,4,8",
+                    help="Comma separated list of thread counts")
+parser.add_argument("-s", "--steps", type=int, default=200, help="Steps executed by each run")
+parser.add_argument("--ppc", type=int, help="Particles per cell of the base problem")
+parser.add_argument("-m", "--mode", choices=["strong", "weak", "both"], default="both")
+parser.add_argument("-d", "--data_path", help="Path to folder with cross section data",
+                    default="../data")
+parser.add_argument("-o", "--out", help="Folder where each run is executed", default="scaling_runs")
+args = parser.parse_args()
+
+base_ny = {5: 257, 6: 513}.get(args.case)
+if base_ny is None:
+    raise ValueError(f"Case {args.case} is not a true-2D scaling case")
+
+threads = [int(t) for t in args.threads.split(",")]
+
+
+def run(name, n_threads, ny):
+    # --ny and --ppc overrides need the generic kernels, so every run uses them to keep the
+    # series comparable. The Poisson share only needs wall time, and --profile-time keeps the
+    # hardware counter reads out of the measured throughput.
+    cmd = [os.path.abspath(args.exe), str(args.case), "--data", os.path.abspath(args.data_path),
+           "--steps", str(args.steps), "--profile-time", "--generic"]
+    if ny != base_ny:
+        cmd += ["--ny", str(ny)]
+    if args.ppc is not None:
+        cmd += ["--ppc", str(args.ppc)]
+
+    run_dir = os.path.join(args.out, f"{name}_{n_threads}")
+    os.makedirs(run_dir, exist_ok=True)
+    env = dict(os.environ, OMP_NUM_THREADS=str(n_threads))
+    out = subprocess.run(cmd, cwd=run_dir, env=env, capture_output=True, text=True, check=True).stdout
+    with open(os.path.join(run_dir, "output.txt"), "w") as f:
+        f.write(out)
+
+    used_threads = int(re.search(r"Threads: (\d+)", out).group(1))
+    if used_threads != n_threads:
+        raise RuntimeError(f"Run {name}_{n_threads} used {used_threads} threads instead of {n_threads}, "
+                           "check that spark-benchmark was built with OpenMP")
+
+    throughput = float(re.search(r"Throughput: (\S+) particle-steps/s", out).group(1))
+    total = out[out.index("Profile (total)"):]
+    poisson_share = float(re.search(r"poisson\s+\S+\s+(\S+)%", total).group(1))
+    return throughput, poisson_share
+
+
+def series(name, ny_of):
+    print(f"{name.capitalize()} scaling (case {args.case}, {args.steps} steps)")
+    print(f"    {'threads':>7} {'grid':>10} {'particle-steps/s':>17} {'efficiency':>10} {'poisson':>8}")
+    base = None
+    for n in threads:
+        ny = ny_of(n)
+        throughput, poisson_share = run(name, n, ny)
+        if base is None:
+            base = throughput / threads[0]
+        # Ideal throughput grows linearly with threads in both series
+        efficiency = throughput / (base * n)
+        print(f"    {n:>7} {f'{base_ny}x{ny}':>10} {throughput:>17.4e} {efficiency * 100.0:>9.1f}% "
+              f"{poisson_share:>7.1f}%")
+    print()
+
+
+if args.mode in ("strong", "both"):
+    series("strong", lambda n: base_ny)
+
+if args.mode in ("weak", "both"):
+    # The domain grows along y so that cells (and particles) per thread stay constant
+    series("weak", lambda n: (base_ny - 1) * n // threads[0] + 1)
@@ -0,0 +1,229 @@
+#include "cross_section_cache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "rapidcsv.h"
+
+namespace {
+    constexpr char magic[8] = {'S', 'P', 'K', 'X', 'S', 'E', 'C', '\0'};
+    constexpr uint32_t version = 1;
+
+    uint64_t fnv1a(const std::vector<char>& bytes) {
+        uint64_t h = 14695981039346656037ull;
+        for (const char c : bytes) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    std::vector<char> read_bytes(const std::filesystem::path& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            throw std::runtime_error("Unable to open cross section file " + path.string());
+        return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    }
+
+    spark::collisions::CrossSection parse_csv(const std::filesystem::path& path, double energy_threshold) {
+        spark::collisions::CrossSection cs;
+        rapidcsv::Document doc(path.string(), rapidcsv::LabelParams(-1, -1),
+                               rapidcsv::SeparatorParams(';'));
+        cs.energy = doc.GetColumn<double>(0);
+        cs.cross_section = doc.GetColumn<double>(1);
+        cs.threshold = energy_threshold;
+        return cs;
+    }
+
+    // Checks that the table is usable by a reaction with the given threshold: sorted energies,
+    // non-negative cross sections and an energy range starting at the threshold.
+    void validate(const std::string& name, const spark::collisions::CrossSection& cs) {
+        const auto fail = [&name](const std::string& what) {
+            throw std::runtime_error("Invalid cross section " + name + ": " + what);
+        };
+
+        if (cs.energy.empty() || cs.energy.size() != cs.cross_section.size())
+            fail("empty table or mismatched columns");
+        if (!std::ranges::is_sorted(cs.energy))
+            fail("energies are not sorted");
+        if (std::ranges::any_of(cs.cross_section, [](double v) { return !(v >= 0.0); }))
+            fail("negative cross section");
+        if (std::abs(cs.energy.front() - cs.threshold) > 1e-6 * std::max(1.0, cs.threshold))
+            fail("table starts at " + std::to_string(cs.energy.front()) + " eV but the reaction threshold is " +
+                 std::to_string(cs.threshold) + " eV");
+        if (cs.energy.back() <= cs.threshold)
+            fail("energy range ends below the reaction threshold");
+    }
+
+    template <typename T>
+    bool read_value(const std::byte*& p, const std::byte* end, T& value) {
+        if (static_cast<size_t>(end - p) < sizeof(T))
+            return false;
+        std::memcpy(&value, p, sizeof(T));
+        p += sizeof(T);
+        return true;
+    }
+
+    template <typename T>
+    void write_value(std::ofstream& out, const T& value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+} // namespace
+
+namespace spark::reactions {
+
+CrossSectionCache::CrossSectionCache(const std::filesystem::path& dir) : dir_(dir) {
+    map_file();
+    parse_records();
+}
+
+CrossSectionCache::~CrossSectionCache() {
+    if (mapped_)
+        munmap(const_cast<std::byte*>(mapped_), mapped_size_);
+}
+
+void CrossSectionCache::map_file() {
+    const int fd = open((dir_ / file_name).c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+
+    struct stat st{};
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* ptr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (ptr != MAP_FAILED) {
+            mapped_ = static_cast<const std::byte*>(ptr);
+            mapped_size_ = static_cast<size_t>(st.st_size);
+        }
+    }
+    close(fd);
+}
+
+void CrossSectionCache::parse_records() {
+    if (!mapped_)
+        return;
+
+    const std::byte* p = mapped_;
+    const std::byte* end = mapped_ + mapped_size_;
+
+    char file_magic[sizeof(magic)];
+    uint32_t file_version = 0;
+    uint32_t n_records = 0;
+    if (!read_value(p, end, file_magic) || std::memcmp(file_magic, magic, sizeof(magic)) != 0 ||
+        !read_value(p, end, file_version) || file_version != version || !read_value(p, end, n_records))
+        return;
+
+    std::vector<Record> records;
+    for (uint32_t i = 0; i < n_records; ++i) {
+        Record r;
+        uint32_t name_size = 0;
+        uint64_t n = 0;
+        if (!read_value(p, end, name_size) || static_cast<size_t>(end - p) < name_size)
+            return;
+        r.name.assign(reinterpret_cast<const char*>(p), name_size);
+        p += name_size;
+
+        if (!read_value(p, end, r.hash) || !read_value(p, end, r.threshold) || !read_value(p, end, n) ||
+            static_cast<size_t>(end - p) / (2 * sizeof(double)) < n)
+            return;
+
+        r.n = static_cast<size_t>(n);
+        r.energy = p;
+        p += r.n * sizeof(double);
+        r.cross_section = p;
+        p += r.n * sizeof(double);
+        records.push_back(std::move(r));
+    }
+
+    // Only a fully readable file is used, a truncated one is rebuilt
+    records_ = std::move(records);
+}
+
+spark::collisions::CrossSection CrossSectionCache::load(const std::string& csv_name, double energy_threshold) {
+    const auto path = dir_ / csv_name;
+    const uint64_t hash = fnv1a(read_bytes(path));
+
+    spark::collisions::CrossSection cs;
+    const auto it = std::ranges::find_if(records_, [&](const Record& r) {
+        return r.name == csv_name && r.hash == hash && r.threshold == energy_threshold;
+    });
+
+    if (it != records_.end()) {
+        cs.energy.resize(it->n);
+        cs.cross_section.resize(it->n);
+        std::memcpy(cs.energy.data(), it->energy, it->n * sizeof(double));
+        std::memcpy(cs.cross_section.data(), it->cross_section, it->n * sizeof(double));
+        cs.threshold = energy_threshold;
+    } else {
+        cs = parse_csv(path, energy_threshold);
+        dirty_ = true;
+    }
+
+    validate(csv_name, cs);
+    loaded_.push_back({csv_name, hash, cs});
+    return cs;
+}
+
+void CrossSectionCache::save() const {
+    if (!dirty_)
+        return;
+
+    // Keep the up to date tables not requested by this run
+    std::vector<Table> tables = loaded_;
+    for (const auto& r : records_) {
+        const bool reloaded = std::ranges::any_of(tables, [&r](const Table& t) { return t.name == r.name; });
+        if (!reloaded) {
+            spark::collisions::CrossSection cs;
+            cs.energy.resize(r.n);
+            cs.cross_section.resize(r.n);
+            std::memcpy(cs.energy.data(), r.energy, r.n * sizeof(double));
+            std::memcpy(cs.cross_section.data(), r.cross_section, r.n * sizeof(double));
+            cs.threshold = r.threshold;
+            tables.push_back({r.name, r.hash, std::move(cs)});
+        }
+    }
+
+    // Written to a temporary file and renamed so that concurrent runs never map a partial cache
+    const auto tmp_path = dir_ / (std::string(file_name) + "." + std::to_string(getpid()) + ".tmp");
+    {
+        std::ofstream out(tmp_path, std::ios::binary);
+        if (!out)
+            return;
+
+        out.write(magic, sizeof(magic));
+        write_value(out, version);
+        write_value(out, static_cast<uint32_t>(tables.size()));
+        for (const auto& t : tables) {
+            write_value(out, static_cast<uint32_t>(t.name.size()));
+            out.write(t.name.data(), static_cast<std::streamsize>(t.name.size()));
+            write_value(out, t.hash);
+            write_value(out, t.cs.threshold);
+            write_value(out, static_cast<uint64_t>(t.cs.energy.size()));
+            out.write(reinterpret_cast<const char*>(t.cs.energy.data()),
+                      static_cast<std::streamsize>(t.cs.energy.size() * sizeof(double)));
+            out.write(reinterpret_cast<const char*>(t.cs.cross_section.data()),
+                      static_cast<std::streamsize>(t.cs.cross_section.size() * sizeof(double)));
+        }
+        if (!out) {
+            out.close();
+            std::error_code ec;
+            std::filesystem::remove(tmp_path, ec);
+            return;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, dir_ / file_name, ec);
+    if (ec)
+        std::filesystem::remove(tmp_path, ec);
+}
+
+} // namespace spark::reactions
@@ -0,0 +1,61 @@
+#ifndef CROSS_SECTION_CACHE_H
+#define CROSS_SECTION_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "spark/collisions/reaction.h"
+
+namespace spark::reactions {
+
+// Binary cache of the cross section tables of a data folder. Each table is stored with the hash of
+// its source CSV and its reaction threshold; tables whose CSV or threshold changed are parsed again
+// and the cache file is rewritten by save().
+class CrossSectionCache {
+public:
+    static constexpr const char* file_name = "cross_sections.bin";
+
+    explicit CrossSectionCache(const std::filesystem::path& dir);
+    ~CrossSectionCache();
+    CrossSectionCache(const CrossSectionCache&) = delete;
+    CrossSectionCache& operator=(const CrossSectionCache&) = delete;
+
+    // Cross section of `csv_name` for a reaction with the given threshold (eV).
+    spark::collisions::CrossSection load(const std::string& csv_name, double energy_threshold);
+
+    // Writes the cache file if any table was parsed from CSV. Failing to write is not an error.
+    void save() const;
+
+private:
+    struct Record {
+        std::string name;
+        uint64_t hash = 0;
+        double threshold = 0.0;
+        size_t n = 0;
+        const std::byte* energy = nullptr; // n doubles in the mapped file, possibly unaligned
+        const std::byte* cross_section = nullptr;
+    };
+
+    struct Table {
+        std::string name;
+        uint64_t hash;
+        spark::collisions::CrossSection cs;
+    };
+
+    void map_file();
+    void parse_records();
+
+    std::filesystem::path dir_;
+    const std::byte* mapped_ = nullptr;
+    size_t mapped_size_ = 0;
+    std::vector<Record> records_;
+    std::vector<Table> loaded_;
+    bool dirty_ = false;
+};
+
+} // namespace spark::reactions
+
+#endif // CROSS_SECTION_CACHE_H
@@ -1,45 +1,194 @@
 #ifndef EVENTS_H
 #define EVENTS_H
 
-#include <unordered_map>
+#include <algorithm>
+#include <cstddef>
+#include <limits>
 #include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace spark {
 
+// Step window in which an action is due: every `stride` steps with step % stride == phase,
+// for start <= step < end.
+struct Schedule {
+    static constexpr size_t never = std::numeric_limits<size_t>::max();
+
+    size_t stride = 1;
+    size_t start = 0;
+    size_t end = never;
+    size_t phase = 0;
+
+    // First due step greater or equal to `from`, or `never` if the window is exhausted.
+    constexpr size_t next_due(size_t from) const {
+        const size_t s = std::max(from, start);
+        if (s >= end)
+            return never;
+
+        const size_t n = std::max<size_t>(stride, 1);
+        const size_t p = phase % n;
+        const size_t r = s % n;
+        const size_t offset = r <= p ? p - r : n - r + p;
+        if (offset >= end - s)
+            return never;
+        return s + offset;
+    }
+};
+
 template <class EventType, class BaseActionType>
 class Events {
 public:
 
     template <class ActionType> requires std::is_base_of_v<BaseActionType, ActionType>
-    std::weak_ptr<ActionType> add_action(EventType event) {
+    std::weak_ptr<ActionType> add_action(EventType event, Schedule schedule = {}) {
         auto ptr = std::make_shared<ActionType>();
-        actions_[event].push_back(ptr);
+        slot(event).add(ptr, schedule);
         return ptr;
     }
 
     template <class ActionType> requires std::is_base_of_v<BaseActionType, ActionType>
-    std::weak_ptr<ActionType> add_action(EventType event, ActionType&& action) {
+    std::weak_ptr<ActionType> add_action(EventType event, ActionType&& action, Schedule schedule = {}) {
         auto ptr = std::make_shared<ActionType>(std::move(action));
-        actions_[event].push_back(ptr);
+        slot(event).add(ptr, schedule);
         return ptr;
     }
 
+    // Notifies every action of the event regardless of its schedule.
+    template <typename... Args>
+    void notify(EventType event, const Args&... args) {
+        const auto i = static_cast<size_t>(event);
+        if (i >= slots_.size())
+            return;
+        for (auto& entry : slots_[i].entries) {
+            entry.action->notify(args...);
+        }
+    }
+
+    // Notifies only the actions of the event that are due at `step`. Steps must be increasing
+    // between calls to rewind().
     template <typename... Args>
-    void notify(EventType event, Args... args) {
-        for (auto& action : actions_[event]) {
-            action->notify(args...);
+    void notify_due(EventType event, size_t step, const Args&... args) {
+        const auto i = static_cast<size_t>(event);
+        if (i >= slots_.size() || step < slots_[i].next_due)
+            return;
+        slots_[i].dispatch(step, args...);
+    }
+
+    // Restarts the schedules from step zero.
+    void rewind() {
+        for (auto& s : slots_) {
+            s.rewind();
         }
     }
 
     void clear() {
-        actions_.clear();
+        slots_.clear();
     }
 
 private:
-    std::unordered_map<EventType, std::vector<std::shared_ptr<BaseActionType>>> actions_;
+    struct Entry {
+        std::shared_ptr<BaseActionType> action;
+        Schedule schedule;
+        size_t next_due;
+    };
+
+    struct Slot {
+        std::vector<Entry> entries;
+        size_t next_due = Schedule::never;
+
+        void add(std::shared_ptr<BaseActionType> action, const Schedule& schedule) {
+            const size_t due = schedule.next_due(0);
+            entries.push_back({std::move(action), schedule, due});
+            next_due = std::min(next_due, due);
+        }
+
+        template <typename... Args>
+        void dispatch(size_t step, const Args&... args) {
+            next_due = Schedule::never;
+            for (auto& entry : entries) {
+                if (entry.next_due <= step) {
+                    if (entry.next_due == step)
+                        entry.action->notify(args...);
+                    entry.next_due = entry.schedule.next_due(step + 1);
+                }
+                next_due = std::min(next_due, entry.next_due);
+            }
+        }
+
+        void rewind() {
+            next_due = Schedule::never;
+            for (auto& entry : entries) {
+                entry.next_due = entry.schedule.next_due(0);
+                next_due = std::min(next_due, entry.next_due);
+            }
+        }
+    };
+
+    Slot& slot(EventType event) {
+        const auto i = static_cast<size_t>(event);
+        if (i >= slots_.size())
+            slots_.resize(i + 1);
+        return slots_[i];
+    }
+
+    std::vector<Slot> slots_;
+};
+
+template <class ActionType>
+struct Scheduled {
+    ActionType action;
+    Schedule schedule;
+    size_t next_due = Schedule::never;
+};
+
+// Fixed set of actions known at compile time. Actions are called directly (no virtual dispatch),
+// and steps with no due action cost a single comparison.
+template <class... ActionTypes>
+class StaticActions {
+public:
+    explicit StaticActions(Scheduled<ActionTypes>... actions) : actions_(std::move(actions)...) {
+        rewind();
+    }
+
+    template <typename... Args>
+    void notify(size_t step, const Args&... args) {
+        if (step < next_due_)
+            return;
+        next_due_ = Schedule::never;
+        std::apply([&](auto&... a) { (dispatch(a, step, args...), ...); }, actions_);
+    }
+
+    void rewind() {
+        next_due_ = Schedule::never;
+        std::apply([this](auto&... a) {
+            ((a.next_due = a.schedule.next_due(0), next_due_ = std::min(next_due_, a.next_due)), ...);
+        }, actions_);
+    }
+
+    template <class ActionType>
+    ActionType& get() { return std::get<Scheduled<ActionType>>(actions_).action; }
+
+    template <class ActionType>
+    const ActionType& get() const { return std::get<Scheduled<ActionType>>(actions_).action; }
+
+private:
+    template <class ActionType, typename... Args>
+    void dispatch(Scheduled<ActionType>& a, size_t step, const Args&... args) {
+        if (a.next_due <= step) {
+            if (a.next_due == step)
+                a.action.notify(args...);
+            a.next_due = a.schedule.next_due(step + 1);
+        }
+        next_due_ = std::min(next_due_, a.next_due);
+    }
 
+    std::tuple<Scheduled<ActionTypes>...> actions_;
+    size_t next_due_ = Schedule::never;
 };
 
 } // spark
 
-#endif //EVENTS_H
\ No newline at end of file
+#endif //EVENTS_H
@@ -0,0 +1,78 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <spark/constants/constants.h>
+
+#include <cmath>
+#include <cstddef>
+
+#include "parameters.h"
+
+namespace spark::kernels {
+
+// Per-step kernels owned by the benchmark. The generic table reads everything from the runtime
+// Parameters; specialized tables take grid sizes and constants from a CaseDescriptor at compile time.
+// Only these two small kernels are specialized, so no measurable speedup is expected until the
+// particle kernels in spark (weighting, interpolation, pusher) can be specialized as well.
+struct KernelTable {
+    void (*reduce_rho)(const Parameters& p, const double* ni, const double* ne, double* rho);
+    double (*boundary_voltage)(const Parameters& p, size_t step);
+    // Case the kernels were specialized on, nullptr for the generic kernels
+    const CaseDescriptor* descriptor;
+
+    // Whether the kernels compute the same results as the generic ones for `p`.
+    bool matches(const Parameters& p) const {
+        if (!descriptor)
+            return true;
+        // Parameters built by Parameters::from_case from the same descriptor compare equal exactly
+        const CaseDescriptor& c = *descriptor;
+        return c.nx == p.nx && c.ny == p.ny && c.ppc == p.ppc && c.dx() == p.dx &&
+               c.particle_weight() == p.particle_weight && c.volt == p.volt && c.f == p.f && c.dt() == p.dt;
+    }
+};
+
+inline void reduce_rho(const Parameters& p, const double* ni, const double* ne, double* rho) {
+    const auto k = constants::e * p.particle_weight / (p.dx * p.dx);
+    const size_t n = p.nx * p.ny;
+
+    for (size_t i = 0; i < n; ++i) {
+        rho[i] = k * (ni[i] - ne[i]);
+    }
+}
+
+inline double boundary_voltage(const Parameters& p, size_t step) {
+    return p.volt * std::sin(2.0 * constants::pi * p.f * p.dt * static_cast<double>(step));
+}
+
+template <const CaseDescriptor& Case>
+void reduce_rho(const Parameters&, const double* ni, const double* ne, double* rho) {
+    constexpr auto k = constants::e * Case.particle_weight() / (Case.dx() * Case.dx());
+
+    for (size_t i = 0; i < Case.nx; ++i) {
+        for (size_t j = 0; j < Case.ny; ++j) {
+            const size_t idx = i * Case.ny + j;
+            rho[idx] = k * (ni[idx] - ne[idx]);
+        }
+    }
+}
+
+template <const CaseDescriptor& Case>
+double boundary_voltage(const Parameters&, size_t step) {
+    constexpr double omega_dt = 2.0 * constants::pi * Case.f * Case.dt();
+    return Case.volt * std::sin(omega_dt * static_cast<double>(step));
+}
+
+inline const KernelTable& generic() {
+    static constexpr KernelTable table{&reduce_rho, &boundary_voltage, nullptr};
+    return table;
+}
+
+template <const CaseDescriptor& Case>
+const KernelTable& specialized() {
+    static constexpr KernelTable table{&reduce_rho<Case>, &boundary_voltage<Case>, &Case};
+    return table;
+}
+
+} // namespace spark::kernels
+
+#endif // KERNELS_H
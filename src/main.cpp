@@ -1,36 +1,48 @@
 #include <argparse/argparse.hpp>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include <algorithm>
+#include <charconv>
 #include <cstdio>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
 #include <string>
 
 #include "spark/random/random.h"
 #include "simulation.h"
 #include "simulation_events.h"
 
-spark::Parameters get_case_parameters(int case_number) {
-    spark::Parameters p;
-
-    switch (case_number) {
-        case 1:
-            p = spark::Parameters::case_1();
-            break;
-        case 2:
-            p = spark::Parameters::case_2();
-            break;
-        case 3:
-            p = spark::Parameters::case_3();
-            break;
-        case 4:
-            p = spark::Parameters::case_4();
-            break;
-        default:
-            break;
-    }
+namespace {
+    struct CaseEntry {
+        const spark::CaseDescriptor& descriptor;
+        const spark::kernels::KernelTable& kernels;
+    };
+
+    // Benchmark cases with kernels specialized on their compile-time descriptors
+    const CaseEntry case_table[] = {
+        {spark::cases::case_1, spark::kernels::specialized<spark::cases::case_1>()},
+        {spark::cases::case_2, spark::kernels::specialized<spark::cases::case_2>()},
+        {spark::cases::case_3, spark::kernels::specialized<spark::cases::case_3>()},
+        {spark::cases::case_4, spark::kernels::specialized<spark::cases::case_4>()},
+        {spark::cases::case_5, spark::kernels::specialized<spark::cases::case_5>()},
+        {spark::cases::case_6, spark::kernels::specialized<spark::cases::case_6>()},
+    };
 
-    return p;
-}
+    // Parses an unsigned override, rejecting values below `min`
+    auto at_least(const std::string& name, size_t min) {
+        return [name, min](const std::string& value) {
+            long long n = 0;
+            const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), n);
+            if (ec != std::errc() || ptr != value.data() + value.size() || n < static_cast<long long>(min))
+                throw std::runtime_error(name + " must be an integer of at least " + std::to_string(min));
+            return static_cast<size_t>(n);
+        };
+    }
+} // namespace
 
 int main(int argc, char* argv[]) {
-    spark::random::initialize(500);
     argparse::ArgumentParser args("spark-benchmark");
 
     int case_number = 0;
@@ -38,7 +50,7 @@ int main(int argc, char* argv[]) {
         .help("Benchmark case to be simulated")
         .scan<'i', int>()
         .default_value(1)
-        .choices(1, 2, 3, 4)
+        .choices(1, 2, 3, 4, 5, 6)
         .store_into(case_number);
 
     std::string data_path{"../data"};
@@ -47,14 +59,92 @@ int main(int argc, char* argv[]) {
         .default_value(data_path)
         .store_into(data_path);
 
-    args.parse_args(argc, argv);
+    args.add_argument("-s", "--steps")
+        .help("Override the number of steps of the case (at least 2)")
+        .action(at_least("--steps", 2));
+
+    args.add_argument("--ppc")
+        .help("Override the particles per cell of the case (at least 1)")
+        .action(at_least("--ppc", 1));
+
+    args.add_argument("--ny")
+        .help("Override the number of vertical cells of the case (at least 2)")
+        .action(at_least("--ny", 2));
+
+    bool generic = false;
+    args.add_argument("-g", "--generic")
+        .help("Use the generic runtime-parameter kernels instead of the case specialized ones")
+        .flag()
+        .store_into(generic);
+
+    bool profile = false;
+    args.add_argument("-p", "--profile")
+        .help("Sample hardware performance counters for each stage of the step loop")
+        .flag()
+        .store_into(profile);
+
+    bool profile_time = false;
+    args.add_argument("--profile-time")
+        .help("Sample only the wall time of each stage of the step loop")
+        .flag()
+        .store_into(profile_time);
+
+    try {
+        args.parse_args(argc, argv);
+    } catch (const std::exception& err) {
+        std::cerr << err.what() << std::endl;
+        std::cerr << args;
+        return 1;
+    }
+
+    // Counters are inherited only by threads created after they are opened, so the profiler is
+    // created before anything that may start a worker pool
+    std::unique_ptr<spark::PhaseProfiler> profiler;
+    if (profile_time) {
+        profiler = std::make_unique<spark::PhaseProfiler>(false);
+    } else if (profile) {
+        profiler = std::make_unique<spark::PhaseProfiler>();
+        if (!profiler->counters_available())
+            printf("Performance counters unavailable, profiling wall time only\n");
+    }
+
+    spark::random::initialize(500);
 
     printf("Starting benchmark case %d simulation\n", case_number);
     printf("Data path set to %s\n", data_path.c_str());
+#ifdef _OPENMP
+    printf("Threads: %d\n", omp_get_max_threads());
+#else
+    printf("Threads: 1 (built without OpenMP)\n");
+#endif
+
+    const CaseEntry& entry = case_table[case_number - 1];
+    spark::CaseDescriptor descriptor = entry.descriptor;
+    if (auto ny = args.present<size_t>("--ny")) {
+        descriptor.ny = *ny;
+        generic = true;
+    }
+    if (auto ppc = args.present<size_t>("--ppc")) {
+        descriptor.ppc = *ppc;
+        generic = true;
+    }
+    if (auto steps = args.present<size_t>("--steps")) {
+        descriptor.n_steps = *steps;
+        descriptor.n_steps_avg = std::min(descriptor.n_steps_avg, *steps);
+    }
+
+    const spark::Parameters parameters = spark::Parameters::from_case(descriptor);
+    printf("Grid %zux%zu, %zu particles per cell, %zu steps\n", parameters.nx, parameters.ny, parameters.ppc,
+           parameters.n_steps);
+
+    // Declared before the simulation so that it outlives the End actions referencing it
+    auto step_actions = spark::make_step_actions(parameters);
 
-    spark::Simulation sim(get_case_parameters(case_number), data_path);
-    spark::setup_events(sim);
-    sim.run();
+    spark::Simulation sim(parameters, data_path, generic ? spark::kernels::generic() : entry.kernels);
+    if (profiler)
+        sim.set_profiler(std::move(profiler));
+    spark::setup_events(sim, step_actions);
+    sim.run(step_actions);
 
     return 0;
 }
\ No newline at end of file
@@ -5,6 +5,75 @@
 
 namespace spark {
 
+// Compile-time description of a benchmark case. Derived quantities are constexpr so that kernels
+// specialized on a descriptor can fold them.
+struct CaseDescriptor {
+    size_t nx; // number of horizontal cells
+    size_t ny; // number of vertical cells
+    double steps_per_period; // time steps per rf period (dimensionless)
+    double ng; // neutral density (m^-3)
+    double n0; // plasma density (m^-3)
+    double volt; // voltage (V)
+    size_t ppc; // particles per cell (dimensionless)
+    size_t n_steps; // steps to execute (dimensionless)
+    size_t n_steps_avg; // steps to average (dimensionless)
+
+    double tg = 300.0; // neutral temperature (K)
+    double te = 30'000.0; // electron temperature (K)
+    double ti = 300.0; // ion temperature (K)
+    double m_he = 6.67e-27; // ion mass (kg)
+    double m_e = 9.109e-31; // electron mass (kg)
+    double lx = 6.7e-2; // horizontal length (cm)
+    double f = 13.56e6; // frequency (Hz)
+
+    constexpr double dt() const { return 1.0 / (steps_per_period * f); }
+    constexpr double dx() const { return lx / static_cast<double>(nx - 1); }
+    constexpr double dy() const { return dx(); }
+    constexpr double ly() const { return dy() * static_cast<double>(ny - 1); }
+    constexpr double particle_weight() const {
+        return (n0 * lx * ly()) / static_cast<double>(ppc * (nx - 1) * (ny - 1));
+    }
+    constexpr size_t n_initial() const { return (nx - 1) * (ny - 1) * ppc; }
+};
+
+namespace cases {
+    inline constexpr CaseDescriptor case_1{
+        .nx = 129, .ny = 4, .steps_per_period = 400.0, .ng = 9.64e20, .n0 = 2.56e14,
+        .volt = 450.0, .ppc = 512, .n_steps = 512'000, .n_steps_avg = 12'800};
+
+    inline constexpr CaseDescriptor case_2{
+        .nx = 257, .ny = 4, .steps_per_period = 800.0, .ng = 32.1e20, .n0 = 5.12e14,
+        .volt = 200.0, .ppc = 256, .n_steps = 4'096'000, .n_steps_avg = 25'600};
+
+    inline constexpr CaseDescriptor case_3{
+        .nx = 513, .ny = 4, .steps_per_period = 1600.0, .ng = 96.4e20, .n0 = 5.12e14,
+        .volt = 150.0, .ppc = 128, .n_steps = 8'192'000, .n_steps_avg = 51'200};
+
+    inline constexpr CaseDescriptor case_4{
+        .nx = 513, .ny = 4, .steps_per_period = 3200.0, .ng = 321.0e20, .n0 = 3.84e14,
+        .volt = 120.0, .ppc = 64, .n_steps = 49'152'000, .n_steps_avg = 102'400};
+
+    // True-2D square domain with the case 1 plasma, used for scaling studies. dt shrinks with the
+    // cell size, as in cases 1-3, to keep the thermal electron Courant number of case 1.
+    constexpr CaseDescriptor scaling_2d(size_t nx, size_t ny, size_t ppc) {
+        CaseDescriptor c = case_1;
+        c.nx = nx;
+        c.ny = ny;
+        c.steps_per_period = case_1.steps_per_period * static_cast<double>(nx - 1) /
+                             static_cast<double>(case_1.nx - 1);
+        c.ppc = ppc;
+        c.n_steps = 1'000;
+        c.n_steps_avg = 100;
+        return c;
+    }
+
+    inline constexpr CaseDescriptor case_5 = scaling_2d(257, 257, 32);
+    inline constexpr CaseDescriptor case_6 = scaling_2d(513, 513, 16);
+
+    static_assert(case_5.steps_per_period == case_2.steps_per_period);
+    static_assert(case_6.steps_per_period == case_3.steps_per_period);
+} // namespace cases
+
 struct Parameters {
     size_t nx;
     size_t ny;
@@ -28,15 +97,9 @@ struct Parameters {
     double particle_weight;
     size_t n_initial;
 
-    static Parameters case_1();
-    static Parameters case_2();
-    static Parameters case_3();
-    static Parameters case_4();
-
-private:
-    void fixed_parameters();
-    void computed_parameters();
+    // Benchmark cases are the descriptors in spark::cases
+    static Parameters from_case(const CaseDescriptor& c);
 };
 
 }  // namespace spark
-#endif  // PARAMETERS_H
\ No newline at end of file
+#endif  // PARAMETERS_H
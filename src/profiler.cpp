@@ -0,0 +1,170 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr const char* phase_names[] = {
+        "weight_to_grid", "reduce_rho", "poisson", "electric_field",
+        "field_at_particles", "move_particles", "boundary", "collisions"};
+
+#ifdef __linux__
+    int open_counter(uint32_t type, uint64_t config) {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+        return fd;
+    }
+#endif
+} // namespace
+
+namespace spark {
+
+PerfCounters::PerfCounters(bool open) {
+    fds_.fill(-1);
+    if (!open)
+        return;
+#ifdef __linux__
+    fds_[Cycles] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    fds_[Instructions] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    fds_[LLCMisses] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    fds_[BranchMisses] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+    for (const int fd : fds_) {
+        if (fd >= 0)
+            close(fd);
+    }
+#endif
+}
+
+bool PerfCounters::any_available() const {
+    return std::ranges::any_of(fds_, [](int fd) { return fd >= 0; });
+}
+
+void PerfCounters::read(Values& values) const {
+#ifdef __linux__
+    for (size_t i = 0; i < NCounters; ++i) {
+        if (fds_[i] < 0)
+            continue;
+
+        // value, time enabled, time running
+        uint64_t buf[3];
+        if (::read(fds_[i], buf, sizeof(buf)) != sizeof(buf) || buf[2] == 0)
+            continue;
+
+        // Extrapolate over the time the counter was multiplexed out
+        values[i] = buf[1] == buf[2]
+                        ? buf[0]
+                        : static_cast<uint64_t>(static_cast<double>(buf[0]) * static_cast<double>(buf[1]) /
+                                                static_cast<double>(buf[2]));
+    }
+#else
+    (void) values;
+#endif
+}
+
+void PhaseProfiler::start(size_t n_particles) {
+    interval_.particle_steps += static_cast<double>(n_particles);
+    interval_.steps++;
+    total_.particle_steps += static_cast<double>(n_particles);
+    total_.steps++;
+    counters_.read(last_);
+    t_last_ = std::chrono::steady_clock::now();
+}
+
+void PhaseProfiler::mark(Phase phase) {
+    auto now_values = last_;
+    counters_.read(now_values);
+    const auto now = std::chrono::steady_clock::now();
+    const auto p = static_cast<size_t>(phase);
+    const double dt = std::chrono::duration<double, std::milli>(now - t_last_).count();
+
+    for (size_t c = 0; c < PerfCounters::NCounters; ++c) {
+        // Scaled counts are estimates and may step back slightly between reads
+        const uint64_t delta = now_values[c] > last_[c] ? now_values[c] - last_[c] : 0;
+        interval_.counts[p][c] += delta;
+        total_.counts[p][c] += delta;
+    }
+    interval_.time_ms[p] += dt;
+    total_.time_ms[p] += dt;
+
+    // Exclude the cost of reading the counters from the next phase
+    last_ = now_values;
+    counters_.read(last_);
+    t_last_ = std::chrono::steady_clock::now();
+}
+
+void PhaseProfiler::report_interval() {
+    report("Profile (last interval)", interval_);
+    reset_interval();
+}
+
+void PhaseProfiler::report_total() const {
+    report("Profile (total)", total_);
+}
+
+void PhaseProfiler::report(const char* title, const Stats& stats) const {
+    if (stats.steps == 0)
+        return;
+
+    double total_ms = 0.0;
+    for (const double t : stats.time_ms)
+        total_ms += t;
+
+    const auto per_particle = [&](size_t p, PerfCounters::Counter c, char* buf, size_t n) {
+        if (counters_.available(c))
+            snprintf(buf, n, "%10.3f", static_cast<double>(stats.counts[p][c]) / stats.particle_steps);
+        else
+            snprintf(buf, n, "%10s", "n/a");
+    };
+
+    printf("%s over %zu steps:\n", title, stats.steps);
+    if (counters_.any_available())
+        printf("    (counters cover the profiling thread and threads created after the profiler)\n");
+    printf("    %-20s %8s %7s %6s %10s %10s\n", "phase", "ms/step", "time%", "IPC", "LLCmiss/p", "brmiss/p");
+    for (size_t p = 0; p < n_phases; ++p) {
+        const double ms_step = stats.time_ms[p] / static_cast<double>(stats.steps);
+        const double share = total_ms > 0.0 ? 100.0 * stats.time_ms[p] / total_ms : 0.0;
+
+        char ipc[16];
+        const auto cycles = stats.counts[p][PerfCounters::Cycles];
+        if (counters_.available(PerfCounters::Cycles) && counters_.available(PerfCounters::Instructions) &&
+            cycles > 0)
+            snprintf(ipc, sizeof(ipc), "%6.2f",
+                     static_cast<double>(stats.counts[p][PerfCounters::Instructions]) / static_cast<double>(cycles));
+        else
+            snprintf(ipc, sizeof(ipc), "%6s", "n/a");
+
+        char llc[16], br[16];
+        per_particle(p, PerfCounters::LLCMisses, llc, sizeof(llc));
+        per_particle(p, PerfCounters::BranchMisses, br, sizeof(br));
+
+        printf("    %-20s %8.3f %6.1f%% %s %s %s\n", phase_names[p], ms_step, share, ipc, llc, br);
+    }
+    printf("\n");
+}
+
+} // namespace spark
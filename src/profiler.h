@@ -0,0 +1,86 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace spark {
+
+// Hardware counters of the calling thread (and threads it spawns afterwards) read through
+// Linux perf_event_open. Counters the kernel or hardware refuses are reported as unavailable.
+// Counts are scaled by enabled/running time, so multiplexed counters remain comparable.
+class PerfCounters {
+public:
+    enum Counter { Cycles, Instructions, LLCMisses, BranchMisses, NCounters };
+    using Values = std::array<uint64_t, NCounters>;
+
+    // Opens no counter when `open` is false, for wall-time-only profiling.
+    explicit PerfCounters(bool open = true);
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available(Counter c) const { return fds_[c] >= 0; }
+    bool any_available() const;
+    // Updates `values` with the current counts, leaving the entries whose read fails untouched.
+    void read(Values& values) const;
+
+private:
+    std::array<int, NCounters> fds_;
+};
+
+// Accumulates counter deltas and wall time between consecutive marks of the step loop.
+class PhaseProfiler {
+public:
+    enum class Phase {
+        WeightToGrid,
+        ReduceRho,
+        Poisson,
+        ElectricField,
+        FieldAtParticles,
+        Move,
+        Boundary,
+        Collisions,
+        NPhases
+    };
+    static constexpr size_t n_phases = static_cast<size_t>(Phase::NPhases);
+
+    // Without `hardware_counters` only wall time is sampled, keeping the overhead to clock reads.
+    explicit PhaseProfiler(bool hardware_counters = true) : counters_(hardware_counters) {}
+
+    bool counters_available() const { return counters_.any_available(); }
+
+    // Starts a step with `n_particles` particles in the simulation.
+    void start(size_t n_particles);
+    // Attributes everything since the previous start/mark to `phase`.
+    void mark(Phase phase);
+
+    // Discards the statistics of the current interval.
+    void reset_interval() { interval_ = Stats{}; }
+    // Prints the statistics since the last interval report and resets them.
+    void report_interval();
+    // Prints the statistics accumulated over the whole run.
+    void report_total() const;
+
+private:
+    struct Stats {
+        std::array<std::array<uint64_t, PerfCounters::NCounters>, n_phases> counts{};
+        std::array<double, n_phases> time_ms{};
+        double particle_steps = 0.0;
+        size_t steps = 0;
+    };
+
+    void report(const char* title, const Stats& stats) const;
+
+    PerfCounters counters_;
+    PerfCounters::Values last_{};
+    std::chrono::steady_clock::time_point t_last_;
+    Stats interval_;
+    Stats total_;
+};
+
+} // namespace spark
+
+#endif // PROFILER_H
@@ -4,14 +4,15 @@
 #include <filesystem>
 
 #include "spark/collisions/reaction.h"
+#include "cross_section_cache.h"
 #include "parameters.h"
 
 namespace spark::reactions {
-spark::collisions::Reactions<2, 3> load_electron_reactions(const std::filesystem::path& dir,
+spark::collisions::Reactions<2, 3> load_electron_reactions(CrossSectionCache& cache,
                                                         const Parameters& par,
                                                         spark::particle::ChargedSpecies<2, 3>& ions);
 
-spark::collisions::Reactions<2, 3> load_ion_reactions(const std::filesystem::path& dir,
+spark::collisions::Reactions<2, 3> load_ion_reactions(CrossSectionCache& cache,
                                                    const Parameters& par);
 }  // namespace spark::reactions
 
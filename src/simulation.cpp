@@ -12,8 +12,10 @@
 #include <spark/random/random.h>
 #include <spark/spatial/grid.h>
 
+#include "cross_section_cache.h"
 #include "reactions.h"
 
+#include <cstdio>
 #include <fstream>
 #include <filesystem>
 
@@ -27,23 +29,41 @@ namespace {
                  spark::random::normal(0.0, vth)};
         };
     }
+
+    const spark::kernels::KernelTable& checked_kernels(const spark::kernels::KernelTable& kernels,
+                                                       const spark::Parameters& parameters) {
+        if (kernels.matches(parameters))
+            return kernels;
+        printf("Specialized kernels do not match the simulation parameters, using generic kernels\n");
+        return spark::kernels::generic();
+    }
 } // namespace
 
 namespace spark {
 
-Simulation::Simulation(const Parameters& parameters, const std::string& data_path)
-    : parameters_(parameters), data_path_(data_path), state_(StateInterface(*this)) {}
+Simulation::Simulation(const Parameters& parameters, const std::string& data_path,
+                       const kernels::KernelTable& kernels)
+    : parameters_(parameters), data_path_(data_path), kernels_(checked_kernels(kernels, parameters)),
+      state_(StateInterface(*this)) {}
 
-void Simulation::run() {
+void Simulation::set_profiler(std::unique_ptr<PhaseProfiler> profiler) {
+    profiler_ = std::move(profiler);
+}
+
+void Simulation::prepare() {
     set_initial_conditions();    
     
-    auto electron_collisions = load_electron_collisions();
-    auto ion_collisions = load_ion_collisions();
+    // A single cache for both species, so a cold start maps and rewrites the cache file once
+    reactions::CrossSectionCache cross_sections(data_path_);
+    load_electron_collisions(cross_sections);
+    load_ion_collisions(cross_sections);
+    cross_sections.save();
 
     em::StructPoissonSolver2D::DomainProp domain_prop;
     domain_prop.extents = {static_cast<int>(parameters_.nx), static_cast<int>(parameters_.ny)};
     domain_prop.dx = {parameters_.dx, parameters_.dy};
 
+    events_.rewind();
     events().notify(Event::Start, state_);
 
     std::vector<em::StructPoissonSolver2D::Region> regions;
@@ -69,56 +89,55 @@ void Simulation::run() {
         []() { return 0.0; }
     });
 
-    double boundary_voltage = 0.0;
+    boundary_voltage_ = 0.0;
     regions.push_back(em::StructPoissonSolver2D::Region{
         em::CellType::BoundaryDirichlet,
         {static_cast<int>(parameters_.nx - 1), 0},
         {static_cast<int>(parameters_.nx - 1), static_cast<int>(parameters_.ny - 1)}, 
-        [&boundary_voltage]() { return boundary_voltage; }
+        [this]() { return boundary_voltage_; }
     });
 
-    auto poisson_solver = em::StructPoissonSolver2D(domain_prop, regions);
+    poisson_solver_.emplace(domain_prop, regions);
+}
 
-    for (step = 0; step < parameters_.n_steps; ++step) {
-        boundary_voltage = parameters_.volt * 
-        std::sin(2.0 * spark::constants::pi * parameters_.f * parameters_.dt * static_cast<double>(step));
+void Simulation::advance() {
+    if (profiler_)
+        profiler_->start(electrons_.n() + ions_.n());
 
-        spark::interpolate::weight_to_grid(electrons_, electron_density_);
-        spark::interpolate::weight_to_grid(ions_, ion_density_);
-        
-        reduce_rho();
+    boundary_voltage_ = kernels_.boundary_voltage(parameters_, step);
 
-        poisson_solver.solve(phi_field_.data(), rho_field_.data());
+    spark::interpolate::weight_to_grid(electrons_, electron_density_);
+    spark::interpolate::weight_to_grid(ions_, ion_density_);
+    mark(PhaseProfiler::Phase::WeightToGrid);
+    
+    reduce_rho();
+    mark(PhaseProfiler::Phase::ReduceRho);
 
-        spark::em::electric_field(phi_field_, electric_field_.data());
+    poisson_solver_->solve(phi_field_.data(), rho_field_.data());
+    mark(PhaseProfiler::Phase::Poisson);
 
-        spark::interpolate::field_at_particles(electric_field_, electrons_, electron_field);
-        spark::interpolate::field_at_particles(electric_field_, ions_, ion_field);
+    spark::em::electric_field(phi_field_, electric_field_.data());
+    mark(PhaseProfiler::Phase::ElectricField);
 
-        spark::particle::move_particles(electrons_, electron_field, parameters_.dt);
-        spark::particle::move_particles(ions_, ion_field, parameters_.dt);
+    spark::interpolate::field_at_particles(electric_field_, electrons_, electron_field);
+    spark::interpolate::field_at_particles(electric_field_, ions_, ion_field);
+    mark(PhaseProfiler::Phase::FieldAtParticles);
 
-        tiled_boundary_.apply(&electrons_);
-        tiled_boundary_.apply(&ions_);
+    spark::particle::move_particles(electrons_, electron_field, parameters_.dt);
+    spark::particle::move_particles(ions_, ion_field, parameters_.dt);
+    mark(PhaseProfiler::Phase::Move);
 
-        electron_collisions.react_all();
-        ion_collisions.react_all();
+    tiled_boundary_.apply(&electrons_);
+    tiled_boundary_.apply(&ions_);
+    mark(PhaseProfiler::Phase::Boundary);
 
-        events().notify(Event::Step, state_);
-    }
-    events().notify(Event::End, state_);
+    electron_collisions_->react_all();
+    ion_collisions_->react_all();
+    mark(PhaseProfiler::Phase::Collisions);
 }
 
 void Simulation::reduce_rho() {
-    const auto k = constants::e * parameters_.particle_weight / (parameters_.dx * parameters_.dx);
-
-    auto* rho_ptr = rho_field_.data_ptr();
-    auto* ne = electron_density_.data_ptr();
-    auto* ni = ion_density_.data_ptr();
-
-    for (size_t i = 0; i < rho_field_.n_total(); ++i) {
-        rho_ptr[i] = k * (ni[i] - ne[i]);
-    }
+    kernels_.reduce_rho(parameters_, ion_density_.data_ptr(), electron_density_.data_ptr(), rho_field_.data_ptr());
 }
 
 Events<Simulation::Event, Simulation::EventAction>& Simulation::events() {
@@ -156,23 +175,23 @@ void Simulation::set_initial_conditions() {
     tiled_boundary_ = spark::particle::TiledBoundary2D(electric_field_.prop(), boundaries, parameters_.dt);
 }
 
-    spark::collisions::MCCReactionSet<2, 3> Simulation::load_electron_collisions() {
-        auto electron_reactions = reactions::load_electron_reactions(data_path_, parameters_, ions_);
+    void Simulation::load_electron_collisions(reactions::CrossSectionCache& cross_sections) {
+        auto electron_reactions = reactions::load_electron_reactions(cross_sections, parameters_, ions_);
         spark::collisions::ReactionConfig<2, 3> electron_reaction_config{
             parameters_.dt, parameters_.dx,
             std::make_unique<spark::collisions::StaticUniformTarget<2, 3>>(parameters_.ng, parameters_.tg),
             std::move(electron_reactions), spark::collisions::RelativeDynamics::FastProjectile};
 
-        return spark::collisions::MCCReactionSet(electrons_, std::move(electron_reaction_config));
+        electron_collisions_.emplace(electrons_, std::move(electron_reaction_config));
     }
 
-    spark::collisions::MCCReactionSet<2, 3> Simulation::load_ion_collisions() {
-        auto ion_reactions = reactions::load_ion_reactions(data_path_, parameters_);
+    void Simulation::load_ion_collisions(reactions::CrossSectionCache& cross_sections) {
+        auto ion_reactions = reactions::load_ion_reactions(cross_sections, parameters_);
         spark::collisions::ReactionConfig<2, 3> ion_reaction_config{
             parameters_.dt, parameters_.dx,
             std::make_unique<spark::collisions::StaticUniformTarget<2, 3>>(parameters_.ng, parameters_.tg),
             std::move(ion_reactions), spark::collisions::RelativeDynamics::SlowProjectile};
 
-        return spark::collisions::MCCReactionSet(ions_, std::move(ion_reaction_config));
+        ion_collisions_.emplace(ions_, std::move(ion_reaction_config));
     }
 } // namespace spark
\ No newline at end of file
@@ -8,14 +8,21 @@
 #include <spark/core/matrix.h>
 #include <spark/particle/boundary.h>
 
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
 #include "events.h"
+#include "kernels.h"
 #include "parameters.h"
+#include "profiler.h"
 #include "spark/core/vec.h"
 
 namespace spark {
+    namespace reactions {
+        class CrossSectionCache;
+    }
 
     class Simulation {
     public:
@@ -32,15 +39,21 @@ namespace spark {
             size_t step() const { return sim_.step; }
             const spark::spatial::UniformGrid<2>& phi_field() const { return sim_.phi_field_; }
             const spark::spatial::TUniformGrid<spark::core::TVec<double, 2>, 2>& electric_field() const { return sim_.electric_field_; }
+            PhaseProfiler* profiler() const { return sim_.profiler_.get(); }
         private:
             Simulation& sim_;
         };
 
         friend StateInterface;
 
-        explicit Simulation(const Parameters& parameters, const std::string& data_path);
+        // Kernels specialized on a case that does not match `parameters` are replaced by the
+        // generic ones.
+        explicit Simulation(const Parameters& parameters, const std::string& data_path,
+                            const kernels::KernelTable& kernels = kernels::generic());
 
-        void run();
+        // Samples `profiler` around each stage of the step loop. The profiler should be created
+        // before anything that spawns threads, since its counters only follow threads created later.
+        void set_profiler(std::unique_ptr<PhaseProfiler> profiler);
 
         enum class Event { Start, Step, End };
 
@@ -52,12 +65,28 @@ namespace spark {
         Events<Event, EventAction>& events();
         StateInterface& state() { return state_; };
 
+        // Runs the simulation notifying `step_actions` (e.g. a StaticActions set) after every step,
+        // in addition to the actions registered in events(). There is no overload without step
+        // actions, so the static set set up for a run cannot be left out by mistake.
+        template <class StepActions>
+        void run(StepActions& step_actions) {
+            prepare();
+            step_actions.rewind();
+            for (step = 0; step < parameters_.n_steps; ++step) {
+                advance();
+                events_.notify_due(Event::Step, step, state_);
+                step_actions.notify(step, state_);
+            }
+            events_.notify(Event::End, state_);
+        }
+
         const spark::spatial::UniformGrid<2>& get_phi_field() const { return phi_field_; }
         const spark::spatial::TUniformGrid<spark::core::TVec<double, 2>, 2>& get_electric_field() const { return electric_field_; }
 
     private:
         Parameters parameters_;
         std::string data_path_;
+        const kernels::KernelTable& kernels_;
         StateInterface state_;
         
         size_t step = 0;
@@ -72,6 +101,18 @@ namespace spark {
 
         Events<Event, EventAction> events_;
 
+        double boundary_voltage_ = 0.0;
+        std::optional<spark::em::StructPoissonSolver2D> poisson_solver_;
+        std::optional<spark::collisions::MCCReactionSet<2, 3>> electron_collisions_;
+        std::optional<spark::collisions::MCCReactionSet<2, 3>> ion_collisions_;
+        std::unique_ptr<PhaseProfiler> profiler_;
+
+        void prepare();
+        void advance();
+        void mark(PhaseProfiler::Phase phase) {
+            if (profiler_)
+                profiler_->mark(phase);
+        }
         void reduce_rho();    
         std::vector<spark::em::StructPoissonSolver2D::Region> region() const;
         spark::spatial::TUniformGrid<spark::core::Vec<2>, 2> convert_electric_field() const;
@@ -81,8 +122,8 @@ namespace spark {
         spark::particle::TiledBoundary2D tiled_boundary_;
 
         void set_initial_conditions();
-        spark::collisions::MCCReactionSet<2, 3> load_electron_collisions();
-        spark::collisions::MCCReactionSet<2, 3> load_ion_collisions();
+        void load_electron_collisions(reactions::CrossSectionCache& cross_sections);
+        void load_ion_collisions(reactions::CrossSectionCache& cross_sections);
     };
 } // namespace spark
 
@@ -32,6 +32,8 @@ namespace {
         return d;
     }
 
+    constexpr size_t print_step_interval = 1000;
+
     template <typename SpeciesType>
     void save_particle_velocities(const char* filename, const SpeciesType& species) {
         std::ofstream out_file(filename);
@@ -46,84 +48,121 @@ namespace {
 
 namespace spark {
 
-void setup_events(Simulation& simulation) {
-    constexpr size_t print_step_interval = 1000;
+void PrintEvolutionAction::notify(const Simulation::StateInterface& s) {
+    auto step = s.step();
+    if (step == 0) {
+        t_last = clk::now();
+        initial_step = 0;
+        // Profile intervals cover the same steps as the average step duration
+        if (auto* profiler = s.profiler())
+            profiler->reset_interval();
+    }
+    if (step > 0) {
+        printf("-");
+    }
+    if ((step % print_step_interval == 0) && (step > 0)) {
+        printf("\n");
+        const auto now = clk::now();
+        const double dur = std::chrono::duration_cast<ms>(now - t_last).count() /
+                           static_cast<double>(s.step() - initial_step);
+        t_last = now;
+        initial_step = step;
+        const float progress = static_cast<float>(step) /
+            static_cast<float>(std::max(1, (int) s.parameters().n_steps - 1));
+        const double dur_per_particle = dur / (static_cast<double>(s.electrons().n() + s.ions().n()));
+        printf("Info (Step: %zu/%zu, %.2f%%):\n", step, s.parameters().n_steps, progress * 100.0);
+        printf("    Avg step duration: %.2fms (%.2eus/p)\n", dur, dur_per_particle * 1e3);
+        printf("    Sim electrons: %zu\n", s.electrons().n());
+        printf("    Sim ions: %zu\n", s.ions().n());
+        printf("\n");
+        if (auto* profiler = s.profiler())
+            profiler->report_interval();
+    }
+}
+
+AverageFieldAction::AverageFieldAction(const Parameters& parameters) {
+    av_electron_density = spark::spatial::AverageGrid<2>({{parameters.lx, parameters.ly}, {parameters.nx, parameters.ny}});
+    av_ion_density = spark::spatial::AverageGrid<2>({{parameters.lx, parameters.ly}, {parameters.nx, parameters.ny}});
+}
+
+void AverageFieldAction::notify(const Simulation::StateInterface& s) {
+    av_electron_density.add(s.electron_density());
+    av_ion_density.add(s.ion_density());
+}
+
+void ThroughputAction::notify(const Simulation::StateInterface& s) {
+    const auto step = s.step();
+    if (step == 0) {
+        t_start = clk::now();
+        last_step = 0;
+        last_n = 0;
+        particle_steps = 0.0;
+    }
+    particle_steps += static_cast<double>(last_n) * static_cast<double>(step - last_step);
+    last_step = step;
+    last_n = s.electrons().n() + s.ions().n();
+}
+
+void ThroughputAction::report(const Simulation::StateInterface& s) const {
+    // Timing starts after step 0, so the remaining steps run up to n_steps - 1
+    const size_t end_step = s.parameters().n_steps - 1;
+    if (end_step == 0)
+        return;
+
+    const double total = particle_steps + static_cast<double>(last_n) * static_cast<double>(end_step - last_step);
+    const double seconds = std::chrono::duration<double>(clk::now() - t_start).count();
+    printf("Throughput: %.4e particle-steps/s (%zu steps in %.3fs)\n", total / seconds, end_step, seconds);
+}
+
+StepActions make_step_actions(const Parameters& parameters) {
+    // Progress is printed every tenth of the print interval, averaging runs over the last n_steps_avg steps
+    const Schedule print_schedule{.stride = print_step_interval / 10};
+    const Schedule average_schedule{.start = parameters.n_steps - parameters.n_steps_avg + 1,
+                                    .end = parameters.n_steps};
 
+    return StepActions({PrintEvolutionAction{}, print_schedule},
+                       {AverageFieldAction(parameters), average_schedule},
+                       {ThroughputAction{}, print_schedule});
+}
+
+void setup_events(Simulation& simulation, const StepActions& step_actions) {
     struct PrintStartAction : public Simulation::EventAction {
         void notify(const Simulation::StateInterface&) override { printf("Starting simulation\n"); }
     };
     simulation.events().add_action<PrintStartAction>(Simulation::Event::Start);
 
-    struct PrintEvolutionAction : public Simulation::EventAction {
-        typedef std::chrono::steady_clock clk;
-        typedef std::chrono::duration<double, std::milli> ms;
-        std::chrono::time_point<std::chrono::steady_clock> t_last;
-        size_t initial_step = 0;
-        void notify(const Simulation::StateInterface& s) override {
-            auto step = s.step();
-            if (step == 0)
-                t_last = clk::now();
-            if ((step % (print_step_interval / 10) == 0) && (step > 0)) {
-                printf("-");
-            }
-            if ((step % print_step_interval == 0) && (step > 0)) {
-                printf("\n");
-                const auto now = clk::now();
-                const double dur = std::chrono::duration_cast<ms>(now - t_last).count() /
-                                   static_cast<double>(s.step() - initial_step);
-                t_last = now;
-                initial_step = step;
-                const float progress = static_cast<float>(step) /
-                    static_cast<float>(std::max(1, (int) s.parameters().n_steps - 1));
-                const double dur_per_particle = dur / (static_cast<double>(s.electrons().n() + s.ions().n()));
-                printf("Info (Step: %zu/%zu, %.2f%%):\n", step, s.parameters().n_steps, progress * 100.0);
-                printf("    Avg step duration: %.2fms (%.2eus/p)\n", dur, dur_per_particle * 1e3);
-                printf("    Sim electrons: %zu\n", s.electrons().n());
-                printf("    Sim ions: %zu\n", s.ions().n());
-                printf("\n");
-            }
-        }
+    struct PrintThroughputAction : public Simulation::EventAction {
+        const ThroughputAction* throughput_action_;
+        explicit PrintThroughputAction(const ThroughputAction& throughput_action)
+            : throughput_action_(&throughput_action) {}
+        void notify(const Simulation::StateInterface& s) override { throughput_action_->report(s); }
     };
-    simulation.events().add_action<PrintEvolutionAction>(Simulation::Event::Step);
+    simulation.events().add_action(Simulation::Event::End,
+        PrintThroughputAction(step_actions.get<ThroughputAction>()));
 
-    struct AverageFieldAction : public Simulation::EventAction {
-        spark::spatial::AverageGrid<2> av_electron_density;
-        spark::spatial::AverageGrid<2> av_ion_density;
-        Parameters parameters_;
-        explicit AverageFieldAction(const Parameters& parameters) : parameters_(parameters) {
-            av_electron_density = spark::spatial::AverageGrid<2>({{parameters_.lx, parameters_.ly}, {parameters_.nx, parameters_.ny}});
-            av_ion_density = spark::spatial::AverageGrid<2>({{parameters_.lx, parameters_.ly}, {parameters_.nx, parameters_.ny}});
-        }
-        void notify(const Simulation::StateInterface& s) override {
-            if (s.step() > parameters_.n_steps - parameters_.n_steps_avg) {
-                av_electron_density.add(s.electron_density());
-                av_ion_density.add(s.ion_density());
-            }
-        }
-    };
-
-    auto avg_field_action = simulation.events().add_action(
-        Simulation::Event::Step, AverageFieldAction(simulation.state().parameters()));
+    if (simulation.state().profiler()) {
+        struct ProfileTotalAction : public Simulation::EventAction {
+            void notify(const Simulation::StateInterface& s) override { s.profiler()->report_total(); }
+        };
+        simulation.events().add_action<ProfileTotalAction>(Simulation::Event::End);
+    }
 
     struct SaveDataAction : public Simulation::EventAction {
-        std::weak_ptr<AverageFieldAction> avg_field_action_;
+        const AverageFieldAction* avg_field_action_;
         Parameters parameters_;
-        explicit SaveDataAction(const std::weak_ptr<AverageFieldAction>& avg_field_action,
-                                const Parameters& parameters)
-            : avg_field_action_(avg_field_action), parameters_(parameters) {}
-        void notify(const Simulation::StateInterface& s) override {
-            if (!avg_field_action_.expired()) {
-                const auto avg_field_action_ptr = avg_field_action_.lock();
-                const auto& avg_e = avg_field_action_ptr->av_electron_density.get();
-                const auto& avg_i = avg_field_action_ptr->av_ion_density.get();
-                auto density_e = count_to_density(parameters_.particle_weight, parameters_.dx, parameters_.dy, avg_e);
-                auto density_i = count_to_density(parameters_.particle_weight, parameters_.dx, parameters_.dy, avg_i);
-                save_vec("density_e.txt", density_e, parameters_.nx, parameters_.ny);
-                save_vec("density_i.txt", density_i, parameters_.nx, parameters_.ny);
-            }
+        explicit SaveDataAction(const AverageFieldAction& avg_field_action, const Parameters& parameters)
+            : avg_field_action_(&avg_field_action), parameters_(parameters) {}
+        void notify(const Simulation::StateInterface&) override {
+            const auto& avg_e = avg_field_action_->av_electron_density.get();
+            const auto& avg_i = avg_field_action_->av_ion_density.get();
+            auto density_e = count_to_density(parameters_.particle_weight, parameters_.dx, parameters_.dy, avg_e);
+            auto density_i = count_to_density(parameters_.particle_weight, parameters_.dx, parameters_.dy, avg_i);
+            save_vec("density_e.txt", density_e, parameters_.nx, parameters_.ny);
+            save_vec("density_i.txt", density_i, parameters_.nx, parameters_.ny);
         }
     };
-    simulation.events().add_action(Simulation::Event::End, SaveDataAction(avg_field_action, simulation.state().parameters()));
+    simulation.events().add_action(Simulation::Event::End,
+        SaveDataAction(step_actions.get<AverageFieldAction>(), simulation.state().parameters()));
 
     struct SaveGridInfoAction : public Simulation::EventAction {
         Parameters parameters_;
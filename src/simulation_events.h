@@ -1,9 +1,44 @@
 #ifndef SIMULATION_EVENTS_H
 #define SIMULATION_EVENTS_H
+
+#include <chrono>
+
 #include "simulation.h"
 
 namespace spark {
-    void setup_events(Simulation& simulation);
+    struct PrintEvolutionAction {
+        typedef std::chrono::steady_clock clk;
+        typedef std::chrono::duration<double, std::milli> ms;
+        std::chrono::time_point<std::chrono::steady_clock> t_last;
+        size_t initial_step = 0;
+        void notify(const Simulation::StateInterface& s);
+    };
+
+    struct AverageFieldAction {
+        spark::spatial::AverageGrid<2> av_electron_density;
+        spark::spatial::AverageGrid<2> av_ion_density;
+        explicit AverageFieldAction(const Parameters& parameters);
+        void notify(const Simulation::StateInterface& s);
+    };
+
+    // Integrates the particle count over the run, sampled at the progress print steps.
+    struct ThroughputAction {
+        typedef std::chrono::steady_clock clk;
+        std::chrono::time_point<std::chrono::steady_clock> t_start;
+        size_t last_step = 0;
+        size_t last_n = 0;
+        double particle_steps = 0.0;
+        void notify(const Simulation::StateInterface& s);
+        void report(const Simulation::StateInterface& s) const;
+    };
+
+    using StepActions = StaticActions<PrintEvolutionAction, AverageFieldAction, ThroughputAction>;
+
+    StepActions make_step_actions(const Parameters& parameters);
+
+    // Registers the Start/End actions. The End actions read results from `step_actions` by reference,
+    // so `step_actions` must outlive every run of `simulation` and be the set passed to run().
+    void setup_events(Simulation& simulation, const StepActions& step_actions);
 } // spark
 
-#endif //SIMULATION_EVENTS_H
\ No newline at end of file
+#endif //SIMULATION_EVENTS_H